@@ -0,0 +1,229 @@
+/*
+ * Path translation, load order and process launch benchmarks
+ *
+ * Measures wine_nt_to_unix_file_name on shallow and deep paths spelled in
+ * another case than on disk, loading and unloading a builtin DLL (which goes
+ * through get_load_order) with the default load order, with a DllOverrides
+ * entry and for the EAC bridge module, LoadLibrary of an already loaded
+ * module, and CreateProcess to process exit round trips. Results are printed
+ * as CSV, in the same format as syncbench:
+ *
+ *   test,threads,iterations,ns_per_op,ops_per_sec
+ *
+ * Usage: pathbench.exe [-n iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <windows.h>
+#include <winternl.h>
+
+#ifndef OBJ_CASE_INSENSITIVE
+#define OBJ_CASE_INSENSITIVE 0x00000040
+#endif
+#ifndef FILE_OPEN
+#define FILE_OPEN 1
+#endif
+
+#define TREE_DEPTH 8
+
+typedef NTSTATUS (WINAPI *nt_to_unix_file_name_func)( const OBJECT_ATTRIBUTES *attr, char *name, ULONG *size,
+                                                       UINT disposition );
+
+static LARGE_INTEGER frequency;
+static LONG iterations = 100000;
+
+static double elapsed_ns( const LARGE_INTEGER *start )
+{
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter( &now );
+    return (double)(now.QuadPart - start->QuadPart) * 1e9 / frequency.QuadPart;
+}
+
+static void report( const char *test, int threads, LONG count, double ns )
+{
+    printf( "%s,%d,%ld,%.1f,%.0f\n", test, threads, count, ns / count, count * 1e9 / ns );
+    fflush( stdout );
+}
+
+/* creates root\PathBench\File.txt and root\PathBench\Dir0\...\Dir7\File.txt, returns the length of root\PathBench */
+static int create_tree( WCHAR *path )
+{
+    int i, len;
+
+    GetTempPathW( MAX_PATH - 64, path );
+    wcscat( path, L"PathBench" );
+    len = wcslen( path );
+    CreateDirectoryW( path, NULL );
+    wcscat( path, L"\\File.txt" );
+    CloseHandle( CreateFileW( path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL ) );
+
+    path[len] = 0;
+    for (i = 0; i < TREE_DEPTH; i++)
+    {
+        _snwprintf( path + wcslen( path ), 8, L"\\Dir%d", i );
+        CreateDirectoryW( path, NULL );
+    }
+    wcscat( path, L"\\File.txt" );
+    CloseHandle( CreateFileW( path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL ) );
+    path[len] = 0;
+    return len;
+}
+
+static void delete_tree( WCHAR *path, int len )
+{
+    int i;
+
+    wcscat( path, L"\\File.txt" );
+    DeleteFileW( path );
+    path[len] = 0;
+    for (i = 0; i < TREE_DEPTH; i++) _snwprintf( path + wcslen( path ), 8, L"\\Dir%d", i );
+    wcscat( path, L"\\File.txt" );
+    DeleteFileW( path );
+    for (i = TREE_DEPTH; i >= 0; i--)
+    {
+        *wcsrchr( path, '\\' ) = 0;
+        RemoveDirectoryW( path );
+    }
+}
+
+static void bench_nt_to_unix( nt_to_unix_file_name_func func, const WCHAR *path, const char *test )
+{
+    WCHAR nt_path[MAX_PATH + 8] = L"\\??\\";
+    OBJECT_ATTRIBUTES attr = { sizeof(attr) };
+    UNICODE_STRING name;
+    LARGE_INTEGER start;
+    char unix_name[MAX_PATH * 3];
+    ULONG size;
+    LONG i;
+
+    wcscat( nt_path, path );
+    name.Buffer = nt_path;
+    name.Length = wcslen( nt_path ) * sizeof(WCHAR);
+    name.MaximumLength = name.Length + sizeof(WCHAR);
+    attr.ObjectName = &name;
+    attr.Attributes = OBJ_CASE_INSENSITIVE;
+
+    size = sizeof(unix_name);
+    if (func( &attr, unix_name, &size, FILE_OPEN )) return;
+
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++)
+    {
+        size = sizeof(unix_name);
+        func( &attr, unix_name, &size, FILE_OPEN );
+    }
+    report( test, 1, iterations, elapsed_ns( &start ) );
+}
+
+static void bench_path_translation(void)
+{
+    nt_to_unix_file_name_func func;
+    WCHAR path[MAX_PATH], upper[MAX_PATH];
+    int i, len;
+
+    /* only exported by the builds that carry the proton_eac patches */
+    func = (void *)GetProcAddress( GetModuleHandleW( L"ntdll.dll" ), "wine_nt_to_unix_file_name" );
+    if (!func) return;
+
+    len = create_tree( path );
+
+    wcscpy( upper, path );
+    wcscat( upper, L"\\File.txt" );
+    CharUpperW( upper + len - 9 );
+    bench_nt_to_unix( func, upper, "nt_to_unix_shallow" );
+
+    wcscpy( upper, path );
+    for (i = 0; i < TREE_DEPTH; i++) _snwprintf( upper + wcslen( upper ), 8, L"\\Dir%d", i );
+    wcscat( upper, L"\\File.txt" );
+    CharUpperW( upper + len - 9 );
+    bench_nt_to_unix( func, upper, "nt_to_unix_deep" );
+
+    delete_tree( path, len );
+}
+
+static void bench_load_cycle( const WCHAR *dll, const char *test )
+{
+    LONG i, count = max( iterations / 100, 10 );
+    LARGE_INTEGER start;
+    HMODULE module;
+
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < count; i++) if ((module = LoadLibraryW( dll ))) FreeLibrary( module );
+    report( test, 1, count, elapsed_ns( &start ) );
+}
+
+static void bench_load_order(void)
+{
+    static const WCHAR builtinW[] = L"builtin";
+    LARGE_INTEGER start;
+    HMODULE module;
+    HKEY key;
+    LONG i;
+
+    bench_load_cycle( L"dciman32.dll", "load_default" );
+
+    if (!RegCreateKeyExW( HKEY_CURRENT_USER, L"Software\\Wine\\DllOverrides", 0, NULL, 0, KEY_ALL_ACCESS, NULL, &key, NULL ))
+    {
+        RegSetValueExW( key, L"msimg32", 0, REG_SZ, (const BYTE *)builtinW, sizeof(builtinW) );
+        bench_load_cycle( L"msimg32.dll", "load_overridden" );
+        RegDeleteValueW( key, L"msimg32" );
+        RegCloseKey( key );
+    }
+
+    /* the bridge isn't installed in the prefix, so this measures the EAC check and the failed search */
+    bench_load_cycle( L"easyanticheat_x64.dll", "load_eac_bridge" );
+
+    module = LoadLibraryW( L"kernel32.dll" );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++) FreeLibrary( LoadLibraryW( L"kernel32.dll" ) );
+    report( "load_loaded", 1, iterations, elapsed_ns( &start ) );
+    FreeLibrary( module );
+}
+
+static void bench_process_launch(void)
+{
+    LONG i, count = max( iterations / 1000, 10 );
+    WCHAR exe[MAX_PATH], cmdline[MAX_PATH + 16];
+    STARTUPINFOW si = { sizeof(si) };
+    PROCESS_INFORMATION pi;
+    LARGE_INTEGER start;
+
+    GetModuleFileNameW( NULL, exe, MAX_PATH );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < count; i++)
+    {
+        _snwprintf( cmdline, ARRAYSIZE(cmdline), L"\"%ls\" -child", exe );
+        if (!CreateProcessW( exe, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi ))
+        {
+            fprintf( stderr, "process_launch: CreateProcessW failed, error %lu\n", GetLastError() );
+            exit( 1 );
+        }
+        WaitForSingleObject( pi.hProcess, INFINITE );
+        CloseHandle( pi.hThread );
+        CloseHandle( pi.hProcess );
+    }
+    report( "process_launch", 1, count, elapsed_ns( &start ) );
+}
+
+int main( int argc, char **argv )
+{
+    int i;
+
+    if (argc > 1 && !strcmp( argv[1], "-child" )) return 0;
+
+    for (i = 1; i < argc - 1; i++)
+        if (!strcmp( argv[i], "-n" )) iterations = max( atol( argv[++i] ), 1 );
+
+    QueryPerformanceFrequency( &frequency );
+    printf( "test,threads,iterations,ns_per_op,ops_per_sec\n" );
+
+    bench_path_translation();
+    bench_load_order();
+    bench_process_launch();
+
+    return 0;
+}
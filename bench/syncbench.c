@@ -0,0 +1,246 @@
+/*
+ * Synchronization primitive benchmarks
+ *
+ * Measures uncontended wait latency, two-thread ping-pong round trips and
+ * contended mutex scaling, so the server / esync / fsync / ntsync backends
+ * can be compared on the same build. Results are printed as CSV:
+ *
+ *   test,threads,iterations,ns_per_op,ops_per_sec
+ *
+ * Usage: syncbench.exe [-n iterations] [-t max_threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+static LARGE_INTEGER frequency;
+static LONG iterations = 100000;
+
+static double elapsed_ns( const LARGE_INTEGER *start )
+{
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter( &now );
+    return (double)(now.QuadPart - start->QuadPart) * 1e9 / frequency.QuadPart;
+}
+
+static void report( const char *test, int threads, LONG count, double ns )
+{
+    printf( "%s,%d,%ld,%.1f,%.0f\n", test, threads, count, ns / count, count * 1e9 / ns );
+    fflush( stdout );
+}
+
+static void bench_wait_single(void)
+{
+    HANDLE event = CreateEventW( NULL, TRUE, TRUE, NULL );
+    LARGE_INTEGER start;
+    LONG i;
+
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++) WaitForSingleObject( event, INFINITE );
+    report( "wait_single_signaled", 1, iterations, elapsed_ns( &start ) );
+
+    ResetEvent( event );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++) WaitForSingleObject( event, 0 );
+    report( "wait_single_timeout0", 1, iterations, elapsed_ns( &start ) );
+
+    CloseHandle( event );
+}
+
+static void bench_wait_multiple(void)
+{
+    HANDLE events[MAXIMUM_WAIT_OBJECTS];
+    LARGE_INTEGER start;
+    LONG i;
+
+    for (i = 0; i < MAXIMUM_WAIT_OBJECTS; i++)
+        events[i] = CreateEventW( NULL, TRUE, i == MAXIMUM_WAIT_OBJECTS - 1, NULL );
+
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++) WaitForMultipleObjects( MAXIMUM_WAIT_OBJECTS, events, FALSE, INFINITE );
+    report( "wait_multiple_any_last", 1, iterations, elapsed_ns( &start ) );
+
+    for (i = 0; i < MAXIMUM_WAIT_OBJECTS; i++) SetEvent( events[i] );
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++) WaitForMultipleObjects( MAXIMUM_WAIT_OBJECTS, events, TRUE, INFINITE );
+    report( "wait_multiple_all", 1, iterations, elapsed_ns( &start ) );
+
+    for (i = 0; i < MAXIMUM_WAIT_OBJECTS; i++) CloseHandle( events[i] );
+}
+
+enum pingpong_kind
+{
+    PINGPONG_EVENT,
+    PINGPONG_SEMAPHORE,
+    PINGPONG_MUTEX,
+};
+
+struct pingpong
+{
+    enum pingpong_kind kind;
+    HANDLE ping, pong;
+    HANDLE mutex;
+};
+
+static void signal_object( enum pingpong_kind kind, HANDLE handle )
+{
+    switch (kind)
+    {
+    case PINGPONG_EVENT: SetEvent( handle ); break;
+    case PINGPONG_SEMAPHORE: ReleaseSemaphore( handle, 1, NULL ); break;
+    case PINGPONG_MUTEX: break;
+    }
+}
+
+static DWORD WINAPI pingpong_thread( void *arg )
+{
+    struct pingpong *pp = arg;
+    LONG i;
+
+    if (pp->kind == PINGPONG_MUTEX)
+    {
+        /* the two threads hand the mutex back and forth, each one waiting for it while the other owns it;
+         * the events tell the owner that the other thread is about to wait, then that it got the mutex,
+         * as a released mutex may otherwise be taken again by the thread that released it */
+        for (i = 0; i < iterations; i++)
+        {
+            SetEvent( pp->pong );
+            WaitForSingleObject( pp->mutex, INFINITE );
+            SetEvent( pp->pong );
+            WaitForSingleObject( pp->ping, INFINITE );
+            ReleaseMutex( pp->mutex );
+            WaitForSingleObject( pp->ping, INFINITE );
+        }
+        return 0;
+    }
+
+    for (i = 0; i < iterations; i++)
+    {
+        WaitForSingleObject( pp->ping, INFINITE );
+        signal_object( pp->kind, pp->pong );
+    }
+    return 0;
+}
+
+static void bench_pingpong( enum pingpong_kind kind, const char *test )
+{
+    struct pingpong pp = { kind };
+    LARGE_INTEGER start;
+    HANDLE thread;
+    LONG i;
+
+    if (kind == PINGPONG_SEMAPHORE)
+    {
+        pp.ping = CreateSemaphoreW( NULL, 0, 1, NULL );
+        pp.pong = CreateSemaphoreW( NULL, 0, 1, NULL );
+    }
+    else
+    {
+        pp.ping = CreateEventW( NULL, FALSE, FALSE, NULL );
+        pp.pong = CreateEventW( NULL, FALSE, FALSE, NULL );
+    }
+    if (kind == PINGPONG_MUTEX) pp.mutex = CreateMutexW( NULL, TRUE, NULL );
+
+    thread = CreateThread( NULL, 0, pingpong_thread, &pp, 0, NULL );
+
+    QueryPerformanceCounter( &start );
+    for (i = 0; i < iterations; i++)
+    {
+        if (kind == PINGPONG_MUTEX)
+        {
+            WaitForSingleObject( pp.pong, INFINITE );
+            ReleaseMutex( pp.mutex );
+            WaitForSingleObject( pp.pong, INFINITE );
+            SetEvent( pp.ping );
+            WaitForSingleObject( pp.mutex, INFINITE );
+            SetEvent( pp.ping );
+        }
+        else
+        {
+            signal_object( kind, pp.ping );
+            WaitForSingleObject( pp.pong, INFINITE );
+        }
+    }
+    report( test, 2, iterations, elapsed_ns( &start ) );
+
+    WaitForSingleObject( thread, INFINITE );
+    CloseHandle( thread );
+    CloseHandle( pp.ping );
+    CloseHandle( pp.pong );
+    if (pp.mutex) CloseHandle( pp.mutex );
+}
+
+struct contention
+{
+    HANDLE mutex;
+    HANDLE start;
+    LONG count;
+};
+
+static DWORD WINAPI contention_thread( void *arg )
+{
+    struct contention *c = arg;
+    LONG i;
+
+    WaitForSingleObject( c->start, INFINITE );
+    for (i = 0; i < c->count; i++)
+    {
+        WaitForSingleObject( c->mutex, INFINITE );
+        ReleaseMutex( c->mutex );
+    }
+    return 0;
+}
+
+static void bench_contention( int threads )
+{
+    struct contention c;
+    HANDLE *handles = malloc( threads * sizeof(*handles) );
+    LARGE_INTEGER start;
+    int i;
+
+    c.mutex = CreateMutexW( NULL, FALSE, NULL );
+    c.start = CreateEventW( NULL, TRUE, FALSE, NULL );
+    c.count = max( iterations / threads, 1 );
+    for (i = 0; i < threads; i++) handles[i] = CreateThread( NULL, 0, contention_thread, &c, 0, NULL );
+
+    QueryPerformanceCounter( &start );
+    SetEvent( c.start );
+    WaitForMultipleObjects( threads, handles, TRUE, INFINITE );
+    report( "mutex_contention", threads, c.count * threads, elapsed_ns( &start ) );
+
+    for (i = 0; i < threads; i++) CloseHandle( handles[i] );
+    CloseHandle( c.start );
+    CloseHandle( c.mutex );
+    free( handles );
+}
+
+int main( int argc, char **argv )
+{
+    SYSTEM_INFO info;
+    int i, max_threads, threads;
+
+    GetSystemInfo( &info );
+    max_threads = min( info.dwNumberOfProcessors * 2, MAXIMUM_WAIT_OBJECTS );
+
+    for (i = 1; i < argc - 1; i++)
+    {
+        if (!strcmp( argv[i], "-n" )) iterations = max( atol( argv[++i] ), 1 );
+        else if (!strcmp( argv[i], "-t" )) max_threads = min( max( atoi( argv[++i] ), 1 ), MAXIMUM_WAIT_OBJECTS );
+    }
+
+    QueryPerformanceFrequency( &frequency );
+    printf( "test,threads,iterations,ns_per_op,ops_per_sec\n" );
+
+    bench_wait_single();
+    bench_wait_multiple();
+    bench_pingpong( PINGPONG_EVENT, "event_pingpong" );
+    bench_pingpong( PINGPONG_SEMAPHORE, "semaphore_pingpong" );
+    bench_pingpong( PINGPONG_MUTEX, "mutex_handoff" );
+    for (threads = 1; threads < max_threads; threads *= 2) bench_contention( threads );
+    bench_contention( max_threads );
+
+    return 0;
+}